@@ -3,24 +3,112 @@
  * This file handles all Basket-related operations for storing small files
  */
 
+#define _POSIX_C_SOURCE 200809L  // clock_gettime, CLOCK_MONOTONIC
+
 #include "fgsls.h"
+#include "fgsls_basket_recovery.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // Forward declarations
 static int _fgsls_allocate_basket_space(fgsls_system_t *system, uint16_t shelf_id, 
                                        uint32_t basket_size, uint64_t *physical_offset);
+static void _fgsls_init_basket_header(fgsls_basket_header_t *header, const fgsls_tag_t *tag,
+                                      uint16_t shelf_id, uint64_t physical_offset,
+                                      uint64_t creation_time);
 static int _fgsls_write_basket_header(fgsls_system_t *system, const fgsls_basket_header_t *header);
 static int _fgsls_read_basket_header(fgsls_system_t *system, const fgsls_tag_t *tag, 
                                     fgsls_basket_header_t *header);
 static int _fgsls_find_free_file_slot(const fgsls_basket_header_t *header, uint32_t *slot_index);
 static int _fgsls_compact_basket(fgsls_system_t *system, fgsls_basket_header_t *header);
+static void _fgsls_update_basket_hash(fgsls_basket_header_t *header);
+static void _fgsls_place_basket_file(fgsls_basket_header_t *header, uint32_t slot_index,
+                                     const fgsls_tag_t *file_tag, const char *filename,
+                                     uint32_t size, uint32_t data_offset, uint64_t creation_time,
+                                     const fgsls_hash_t *file_hash);
+static void _fgsls_remove_basket_file(fgsls_basket_header_t *header,
+                                      fgsls_basket_file_entry_t *file_entry);
+static void _fgsls_build_garbage_item(fgsls_garbage_item_t *garbage_item, uint16_t shelf_id,
+                                      const fgsls_basket_file_entry_t *file_entry,
+                                      uint64_t deletion_time);
+static void _fgsls_init_basket_journal_record(fgsls_basket_journal_record_t *record,
+                                              uint8_t record_type);
+static fgsls_position_entry_t *_fgsls_find_basket_position(fgsls_system_t *system,
+                                                           const fgsls_tag_t *tag);
+static void _fgsls_quarantine_garbage_item(fgsls_system_t *system,
+                                           const fgsls_garbage_item_t *garbage_item);
+static void _fgsls_fill_basket_position(fgsls_position_entry_t *entry, const fgsls_tag_t *basket_tag,
+                                       const fgsls_tag_t *file_tag, uint16_t shelf_id,
+                                       uint64_t physical_offset, uint32_t internal_offset);
 static int _fgsls_update_basket_position(fgsls_system_t *system, const fgsls_tag_t *basket_tag,
                                         const fgsls_tag_t *file_tag, uint16_t shelf_id, 
                                         uint64_t physical_offset, uint32_t internal_offset);
 
+/**
+ * How replay treats a single journal record
+ */
+typedef enum {
+    REPLAY_RECORD_SKIP,               // Checkpointed or non-mutating
+    REPLAY_RECORD_APPLY,              // Part of the tail to replay
+    REPLAY_RECORD_REJECT              // Malformed for this system
+} _fgsls_replay_disposition_t;
+
+/**
+ * Basket header cached by a replay partition
+ */
+typedef struct {
+    bool loaded;                      // Header read from storage or created in the tail
+    bool missing;                     // Basket not found in the checkpointed index
+    bool dirty;                       // Header must be written back
+    fgsls_basket_header_t header;
+} _fgsls_replay_basket_t;
+
+/**
+ * Per-partition replay state. Each partition owns a disjoint set of shelves,
+ * and so of baskets: workers update shelf and basket headers directly and
+ * only stage changes to the shared Taver index and quarantine zone.
+ */
+typedef struct {
+    fgsls_system_t *system;
+    const fgsls_basket_journal_record_t **records;  // Sorted by sequence_number
+    uint64_t record_count;
+    fgsls_tag_t *basket_tags;               // Sorted, distinct baskets touched
+    _fgsls_replay_basket_t *baskets;        // Parallel to basket_tags
+    uint64_t basket_count;
+    fgsls_position_entry_t *added;          // Taver entries to append
+    uint64_t added_count;
+    fgsls_garbage_item_t *removed;          // Checkpointed files to drop, quarantined
+    uint64_t removed_count;                 // only if the merge finds them
+    fgsls_garbage_item_t *garbage;          // Quarantine items for tail-local deletes
+    uint64_t garbage_count;
+    uint64_t replayed;
+    uint64_t rejected;
+    uint64_t baskets_restored;
+    uint64_t files_restored;
+    uint64_t files_removed;
+    int result;
+} _fgsls_replay_partition_t;
+
+static _fgsls_replay_disposition_t _fgsls_replay_record_disposition(
+    const fgsls_system_t *system, const fgsls_basket_journal_record_t *record,
+    uint64_t checkpoint_sequence);
+static void *_fgsls_replay_partition(void *arg);
+static _fgsls_replay_basket_t *_fgsls_replay_load_basket(_fgsls_replay_partition_t *partition,
+                                                         const fgsls_tag_t *basket_tag);
+static int _fgsls_compare_journal_sequence(const void *a, const void *b);
+static int _fgsls_compare_tag_order(const void *a, const void *b);
+static int _fgsls_compare_garbage_tag_order(const void *a, const void *b);
+static int _fgsls_compare_tag_to_garbage(const void *key, const void *item);
+static int _fgsls_merge_replayed_removals(fgsls_system_t *system, fgsls_garbage_item_t *removed,
+                                          uint64_t removed_count, uint64_t *files_removed);
+static int _fgsls_merge_replayed_additions(fgsls_system_t *system,
+                                           const _fgsls_replay_partition_t *partitions,
+                                           uint32_t partition_count);
+
 /**
  * Create a new Basket
  */
@@ -61,25 +149,7 @@ int fgsls_create_basket(fgsls_system_t *system, uint16_t shelf_id, fgsls_tag_t *
     
     // Create basket header
     fgsls_basket_header_t header;
-    memset(&header, 0, sizeof(header));
-    
-    fgsls_copy_tag(&header.tag, tag);
-    header.shelf_id = shelf_id;
-    header.basket_size = BASKET_DEFAULT_SIZE;
-    header.file_count = 0;
-    header.deleted_count = 0;
-    header.used_space = sizeof(fgsls_basket_header_t); // Header takes space
-    header.free_space = BASKET_DEFAULT_SIZE - header.used_space;
-    header.creation_time = fgsls_get_current_time();
-    header.last_compaction = header.creation_time;
-    header.compaction_count = 0;
-    header.physical_offset = physical_offset;
-    
-    // Initialize all file entries as unused
-    for (int i = 0; i < BASKET_MAX_FILES; i++) {
-        memset(&header.files[i], 0, sizeof(fgsls_basket_file_entry_t));
-        header.files[i].is_deleted = true; // Mark as unused
-    }
+    _fgsls_init_basket_header(&header, tag, shelf_id, physical_offset, fgsls_get_current_time());
     
     // Write basket header
     result = _fgsls_write_basket_header(system, &header);
@@ -99,18 +169,20 @@ int fgsls_create_basket(fgsls_system_t *system, uint16_t shelf_id, fgsls_tag_t *
     shelf->config.free_size = shelf->config.total_size - shelf->config.used_size;
     
     // Log journal entry
-    sant_journal_entry_t journal_entry;
-    memset(&journal_entry, 0, sizeof(journal_entry));
-    journal_entry.sequence_number = system->total_writes++;
-    journal_entry.timestamp = fgsls_get_current_time();
-    journal_entry.operation_type = JOURNAL_WRITE;
-    fgsls_copy_tag(&journal_entry.target_tag, tag);
-    journal_entry.shelf_id = shelf_id;
-    journal_entry.data_size = BASKET_DEFAULT_SIZE;
-    snprintf(journal_entry.description, sizeof(journal_entry.description),
+    fgsls_basket_journal_record_t journal_record;
+    _fgsls_init_basket_journal_record(&journal_record, BASKET_RECORD_CREATE);
+    journal_record.entry.sequence_number = system->total_writes++;
+    journal_record.entry.timestamp = fgsls_get_current_time();
+    journal_record.entry.operation_type = JOURNAL_WRITE;
+    fgsls_copy_tag(&journal_record.entry.target_tag, tag);
+    journal_record.entry.shelf_id = shelf_id;
+    journal_record.entry.data_size = BASKET_DEFAULT_SIZE;
+    snprintf(journal_record.entry.description, sizeof(journal_record.entry.description),
              "Created basket on shelf %d", shelf_id);
+    fgsls_copy_tag(&journal_record.basket_tag, tag);
+    journal_record.basket_offset = physical_offset;
     
-    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_entry, sizeof(journal_entry));
+    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_record, sizeof(journal_record));
     
     FGSLS_DEBUG_PRINT("Created basket on shelf %d", shelf_id);
     FGSLS_TRACE_EXIT("fgsls_create_basket", FGSLS_SUCCESS);
@@ -179,36 +251,18 @@ int fgsls_add_file_to_basket(fgsls_system_t *system, const fgsls_tag_t *basket_t
     // Generate file tag
     *file_tag = fgsls_generate_tag();
     
-    // Create file entry
-    fgsls_basket_file_entry_t *file_entry = &header.files[slot_index];
-    memset(file_entry, 0, sizeof(*file_entry));
-    
-    fgsls_copy_tag(&file_entry->tag, file_tag);
-    strncpy(file_entry->filename, filename, sizeof(file_entry->filename) - 1);
-    file_entry->file_size = size;
-    file_entry->data_offset = header.basket_size - header.free_space; // Add to end
-    file_entry->creation_time = fgsls_get_current_time();
-    file_entry->modification_time = file_entry->creation_time;
-    file_entry->access_time = file_entry->creation_time;
-    file_entry->data_type = DATA_TYPE_UNKNOWN; // Could be detected from filename
-    file_entry->permissions = 0644; // Default permissions
-    file_entry->is_deleted = false;
-    
     // Calculate file hash
-    fgsls_calculate_hash(data, size, &file_entry->file_hash);
+    fgsls_hash_t file_hash;
+    fgsls_calculate_hash(data, size, &file_hash);
+    
+    uint32_t data_offset = header.basket_size - header.free_space; // Add to end
     
     // TODO: Write file data to basket at data_offset
     // In real implementation, this would write to physical storage
     
-    // Update basket header
-    header.file_count++;
-    header.used_space += size;
-    header.free_space -= size;
-    
-    // Calculate basket hash
-    fgsls_basket_header_t temp_header = header;
-    memset(&temp_header.basket_hash, 0, sizeof(temp_header.basket_hash));
-    fgsls_calculate_hash(&temp_header, sizeof(temp_header), &header.basket_hash);
+    // Create file entry and update basket header
+    _fgsls_place_basket_file(&header, slot_index, file_tag, filename, size, data_offset,
+                             fgsls_get_current_time(), &file_hash);
     
     // Write updated basket header
     result = _fgsls_write_basket_header(system, &header);
@@ -218,24 +272,31 @@ int fgsls_add_file_to_basket(fgsls_system_t *system, const fgsls_tag_t *basket_t
     
     // Update Taver index for the file
     result = _fgsls_update_basket_position(system, basket_tag, file_tag, header.shelf_id,
-                                          header.physical_offset, file_entry->data_offset);
+                                          header.physical_offset, data_offset);
     if (result != FGSLS_SUCCESS) {
         return result;
     }
     
     // Log journal entry
-    sant_journal_entry_t journal_entry;
-    memset(&journal_entry, 0, sizeof(journal_entry));
-    journal_entry.sequence_number = system->total_writes++;
-    journal_entry.timestamp = fgsls_get_current_time();
-    journal_entry.operation_type = JOURNAL_WRITE;
-    fgsls_copy_tag(&journal_entry.target_tag, file_tag);
-    journal_entry.shelf_id = header.shelf_id;
-    journal_entry.data_size = size;
-    snprintf(journal_entry.description, sizeof(journal_entry.description),
+    fgsls_basket_journal_record_t journal_record;
+    _fgsls_init_basket_journal_record(&journal_record, BASKET_RECORD_ADD_FILE);
+    journal_record.entry.sequence_number = system->total_writes++;
+    journal_record.entry.timestamp = fgsls_get_current_time();
+    journal_record.entry.operation_type = JOURNAL_WRITE;
+    fgsls_copy_tag(&journal_record.entry.target_tag, file_tag);
+    journal_record.entry.shelf_id = header.shelf_id;
+    journal_record.entry.data_size = size;
+    snprintf(journal_record.entry.description, sizeof(journal_record.entry.description),
              "Added file '%s' (%u bytes) to basket", filename, size);
+    fgsls_copy_tag(&journal_record.basket_tag, basket_tag);
+    journal_record.basket_offset = header.physical_offset;
+    journal_record.slot_index = slot_index;
+    journal_record.data_offset = data_offset;
+    journal_record.file_size = size;
+    strncpy(journal_record.filename, filename, sizeof(journal_record.filename) - 1);
+    memcpy(&journal_record.file_hash, &file_hash, sizeof(fgsls_hash_t));
     
-    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_entry, sizeof(journal_entry));
+    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_record, sizeof(journal_record));
     
     FGSLS_DEBUG_PRINT("Added file '%s' (%u bytes) to basket on shelf %d", 
                       filename, size, header.shelf_id);
@@ -346,18 +407,20 @@ int fgsls_read_file_from_basket(fgsls_system_t *system, const fgsls_tag_t *file_
     system->total_reads++;
     
     // Log journal entry
-    sant_journal_entry_t journal_entry;
-    memset(&journal_entry, 0, sizeof(journal_entry));
-    journal_entry.sequence_number = system->total_reads;
-    journal_entry.timestamp = fgsls_get_current_time();
-    journal_entry.operation_type = JOURNAL_READ;
-    fgsls_copy_tag(&journal_entry.target_tag, file_tag);
-    journal_entry.shelf_id = header.shelf_id;
-    journal_entry.data_size = file_entry->file_size;
-    snprintf(journal_entry.description, sizeof(journal_entry.description),
+    fgsls_basket_journal_record_t journal_record;
+    _fgsls_init_basket_journal_record(&journal_record, BASKET_RECORD_READ_FILE);
+    journal_record.entry.sequence_number = system->total_reads;
+    journal_record.entry.timestamp = fgsls_get_current_time();
+    journal_record.entry.operation_type = JOURNAL_READ;
+    fgsls_copy_tag(&journal_record.entry.target_tag, file_tag);
+    journal_record.entry.shelf_id = header.shelf_id;
+    journal_record.entry.data_size = file_entry->file_size;
+    snprintf(journal_record.entry.description, sizeof(journal_record.entry.description),
              "Read file '%s' (%u bytes) from basket", file_entry->filename, file_entry->file_size);
+    fgsls_copy_tag(&journal_record.basket_tag, &basket_tag);
+    journal_record.basket_offset = header.physical_offset;
     
-    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_entry, sizeof(journal_entry));
+    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_record, sizeof(journal_record));
     
     FGSLS_DEBUG_PRINT("Read file '%s' (%u bytes) from basket on shelf %d", 
                       file_entry->filename, file_entry->file_size, header.shelf_id);
@@ -437,39 +500,14 @@ int fgsls_delete_file_from_basket(fgsls_system_t *system, const fgsls_tag_t *fil
     
     // Create garbage item for ZHT
     fgsls_garbage_item_t garbage_item;
-    memset(&garbage_item, 0, sizeof(garbage_item));
-    fgsls_copy_tag(&garbage_item.tag, file_tag);
-    garbage_item.garbage_type = GARBAGE_ORPHANED_BASKET_FILE;
-    garbage_item.shelf_id = header.shelf_id;
-    garbage_item.size = file_entry->file_size;
-    garbage_item.deletion_time = fgsls_get_current_time();
-    garbage_item.quarantine_time = garbage_item.deletion_time;
-    garbage_item.is_recoverable = true;
-    memcpy(&garbage_item.data_hash, &file_entry->file_hash, sizeof(fgsls_hash_t));
-    snprintf(garbage_item.description, sizeof(garbage_item.description),
-             "Deleted file '%s' from basket", file_entry->filename);
+    _fgsls_build_garbage_item(&garbage_item, header.shelf_id, file_entry, fgsls_get_current_time());
     
     // Add to quarantine zone
-    fgsls_quarantine_zone_t *quarantine = &system->zht_config.quarantine;
-    if (quarantine->current_items < quarantine->max_items) {
-        quarantine->items[quarantine->current_items] = garbage_item;
-        quarantine->current_items++;
-        quarantine->total_size += file_entry->file_size;
-    }
+    _fgsls_quarantine_garbage_item(system, &garbage_item);
     
-    // Mark file as deleted (soft delete)
-    file_entry->is_deleted = true;
-    
-    // Update basket statistics
-    header.file_count--;
-    header.deleted_count++;
-    header.used_space -= file_entry->file_size;
-    header.free_space += file_entry->file_size;
-    
-    // Recalculate basket hash
-    fgsls_basket_header_t temp_header = header;
-    memset(&temp_header.basket_hash, 0, sizeof(temp_header.basket_hash));
-    fgsls_calculate_hash(&temp_header, sizeof(temp_header), &header.basket_hash);
+    // Mark file as deleted (soft delete) and update basket statistics
+    uint32_t slot_index = (uint32_t)(file_entry - header.files);
+    _fgsls_remove_basket_file(&header, file_entry);
     
     // Write updated basket header
     result = _fgsls_write_basket_header(system, &header);
@@ -483,24 +521,285 @@ int fgsls_delete_file_from_basket(fgsls_system_t *system, const fgsls_tag_t *fil
     taver->entry_count--;
     
     // Log journal entry
-    sant_journal_entry_t journal_entry;
-    memset(&journal_entry, 0, sizeof(journal_entry));
-    journal_entry.sequence_number = system->total_writes++;
-    journal_entry.timestamp = fgsls_get_current_time();
-    journal_entry.operation_type = JOURNAL_DELETE;
-    fgsls_copy_tag(&journal_entry.target_tag, file_tag);
-    journal_entry.shelf_id = header.shelf_id;
-    journal_entry.data_size = garbage_item.size;
-    snprintf(journal_entry.description, sizeof(journal_entry.description),
+    fgsls_basket_journal_record_t journal_record;
+    _fgsls_init_basket_journal_record(&journal_record, BASKET_RECORD_DELETE_FILE);
+    journal_record.entry.sequence_number = system->total_writes++;
+    journal_record.entry.timestamp = fgsls_get_current_time();
+    journal_record.entry.operation_type = JOURNAL_DELETE;
+    fgsls_copy_tag(&journal_record.entry.target_tag, file_tag);
+    journal_record.entry.shelf_id = header.shelf_id;
+    journal_record.entry.data_size = garbage_item.size;
+    snprintf(journal_record.entry.description, sizeof(journal_record.entry.description),
              "Deleted file '%s' from basket", garbage_item.description + 13); // Skip "Deleted file '"
+    fgsls_copy_tag(&journal_record.basket_tag, &basket_tag);
+    journal_record.basket_offset = header.physical_offset;
+    journal_record.slot_index = slot_index;
+    journal_record.data_offset = file_entry->data_offset;
+    journal_record.file_size = file_entry->file_size;
+    strncpy(journal_record.filename, file_entry->filename, sizeof(journal_record.filename) - 1);
+    memcpy(&journal_record.file_hash, &file_entry->file_hash, sizeof(fgsls_hash_t));
     
-    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_entry, sizeof(journal_entry));
+    fgsls_write_journal_entry(system, JOURNAL_WAREHOUSING_ENGINE, &journal_record, sizeof(journal_record));
     
     FGSLS_DEBUG_PRINT("Deleted file from basket on shelf %d", header.shelf_id);
     FGSLS_TRACE_EXIT("fgsls_delete_file_from_basket", FGSLS_SUCCESS);
     return FGSLS_SUCCESS;
 }
 
+/**
+ * Decode one warehousing journal payload into a basket record
+ */
+int fgsls_decode_basket_journal_record(const void *data, size_t size,
+                                       fgsls_basket_journal_record_t *record) {
+    if (!data || !record || size != sizeof(*record)) {
+        return FGSLS_ERROR_INVALID_PARAMETER;
+    }
+    
+    memcpy(record, data, sizeof(*record));
+    
+    if (record->record_magic != FGSLS_BASKET_JOURNAL_MAGIC ||
+        record->record_version != FGSLS_BASKET_JOURNAL_VERSION ||
+        record->record_size != sizeof(*record)) {
+        return FGSLS_ERROR_CORRUPTED_DATA;
+    }
+    
+    return FGSLS_SUCCESS;
+}
+
+/**
+ * Replay the warehousing journal tail after a checkpoint
+ */
+int fgsls_replay_basket_journal(fgsls_system_t *system,
+                                const fgsls_basket_journal_record_t *records,
+                                uint64_t record_count, uint64_t checkpoint_sequence,
+                                uint32_t worker_count, fgsls_recovery_stats_t *stats) {
+    FGSLS_TRACE_ENTER("fgsls_replay_basket_journal");
+    
+    if (!system || (!records && record_count > 0) || system->shelf_count == 0) {
+        return FGSLS_ERROR_INVALID_PARAMETER;
+    }
+    
+    if (!system->is_mounted) {
+        return FGSLS_ERROR_SYSTEM_NOT_MOUNTED;
+    }
+    
+    fgsls_recovery_stats_t local_stats;
+    if (!stats) {
+        stats = &local_stats;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->checkpoint_sequence = checkpoint_sequence;
+    stats->records_scanned = record_count;
+    
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    
+    // Pick partition count: one per worker, never more than there are shelves
+    if (worker_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = online > 0 ? (uint32_t)online : 1;
+    }
+    if (worker_count > FGSLS_RECOVERY_MAX_WORKERS) {
+        worker_count = FGSLS_RECOVERY_MAX_WORKERS;
+    }
+    if (worker_count > system->shelf_count) {
+        worker_count = system->shelf_count;
+    }
+    stats->partition_count = worker_count;
+    
+    _fgsls_replay_partition_t partitions[FGSLS_RECOVERY_MAX_WORKERS];
+    memset(partitions, 0, sizeof(partitions));
+    
+    // First pass: drop the checkpointed prefix and count records per partition
+    uint64_t tail_count = 0;
+    for (uint64_t i = 0; i < record_count; i++) {
+        const fgsls_basket_journal_record_t *record = &records[i];
+        
+        switch (_fgsls_replay_record_disposition(system, record, checkpoint_sequence)) {
+        case REPLAY_RECORD_SKIP:
+            stats->records_skipped++;
+            break;
+        case REPLAY_RECORD_REJECT:
+            FGSLS_DEBUG_PRINT("Journal record %llu is not replayable (type %d, shelf %d)",
+                              (unsigned long long)record->entry.sequence_number,
+                              record->record_type, record->entry.shelf_id);
+            stats->records_rejected++;
+            break;
+        case REPLAY_RECORD_APPLY:
+            partitions[record->entry.shelf_id % worker_count].record_count++;
+            tail_count++;
+            break;
+        }
+    }
+    
+    int result = FGSLS_SUCCESS;
+    
+    if (tail_count > 0) {
+        // Staging buffers: every tail record yields at most one change of each kind
+        const fgsls_basket_journal_record_t **tail = malloc(tail_count * sizeof(*tail));
+        fgsls_position_entry_t *added = malloc(tail_count * sizeof(*added));
+        fgsls_garbage_item_t *removed = malloc(tail_count * sizeof(*removed));
+        fgsls_garbage_item_t *garbage = malloc(tail_count * sizeof(*garbage));
+        
+        if (!tail || !added || !removed || !garbage) {
+            result = FGSLS_ERROR_OUT_OF_MEMORY;
+        } else {
+            uint64_t base = 0;
+            for (uint32_t p = 0; p < worker_count; p++) {
+                partitions[p].system = system;
+                partitions[p].records = tail + base;
+                partitions[p].added = added + base;
+                partitions[p].removed = removed + base;
+                partitions[p].garbage = garbage + base;
+                partitions[p].result = FGSLS_SUCCESS;
+                base += partitions[p].record_count;
+                partitions[p].record_count = 0;
+            }
+            
+            // Second pass: scatter the tail into its partitions
+            for (uint64_t i = 0; i < record_count; i++) {
+                const fgsls_basket_journal_record_t *record = &records[i];
+                
+                if (_fgsls_replay_record_disposition(system, record, checkpoint_sequence) !=
+                    REPLAY_RECORD_APPLY) {
+                    continue;
+                }
+                
+                _fgsls_replay_partition_t *partition =
+                    &partitions[record->entry.shelf_id % worker_count];
+                partition->records[partition->record_count++] = record;
+            }
+            
+            // Replay partitions in parallel; the last one runs on this thread,
+            // as does any partition whose thread cannot be started
+            pthread_t threads[FGSLS_RECOVERY_MAX_WORKERS];
+            bool started[FGSLS_RECOVERY_MAX_WORKERS];
+            
+            for (uint32_t p = 0; p < worker_count; p++) {
+                started[p] = false;
+                if (partitions[p].record_count == 0) {
+                    continue;
+                }
+                if (p + 1 < worker_count &&
+                    pthread_create(&threads[p], NULL, _fgsls_replay_partition, &partitions[p]) == 0) {
+                    started[p] = true;
+                } else {
+                    _fgsls_replay_partition(&partitions[p]);
+                }
+            }
+            
+            uint64_t removed_count = 0;
+            
+            for (uint32_t p = 0; p < worker_count; p++) {
+                if (started[p]) {
+                    pthread_join(threads[p], NULL);
+                }
+                
+                _fgsls_replay_partition_t *partition = &partitions[p];
+                if (partition->result != FGSLS_SUCCESS && result == FGSLS_SUCCESS) {
+                    result = partition->result;
+                }
+                
+                stats->records_replayed += partition->replayed;
+                stats->records_rejected += partition->rejected;
+                stats->baskets_restored += partition->baskets_restored;
+                stats->files_restored += partition->files_restored;
+                stats->files_removed += partition->files_removed;
+                if (partition->record_count > 0 &&
+                    partition->records[partition->record_count - 1]->entry.sequence_number >
+                    stats->last_sequence) {
+                    stats->last_sequence =
+                        partition->records[partition->record_count - 1]->entry.sequence_number;
+                }
+                
+                // Gather staged removals contiguously for the merge
+                memmove(&removed[removed_count], partition->removed,
+                        partition->removed_count * sizeof(fgsls_garbage_item_t));
+                removed_count += partition->removed_count;
+            }
+            
+            // Merge staged changes serially. A staged removal is only counted
+            // as replayed, and its item quarantined, once its Taver entry is found.
+            if (result == FGSLS_SUCCESS) {
+                uint64_t files_removed = 0;
+                result = _fgsls_merge_replayed_removals(system, removed, removed_count,
+                                                        &files_removed);
+                stats->files_removed += files_removed;
+                stats->records_replayed += files_removed;
+                stats->records_rejected += removed_count - files_removed;
+            }
+            
+            if (result == FGSLS_SUCCESS) {
+                result = _fgsls_merge_replayed_additions(system, partitions, worker_count);
+            }
+            
+            if (result == FGSLS_SUCCESS) {
+                for (uint32_t p = 0; p < worker_count; p++) {
+                    for (uint64_t g = 0; g < partitions[p].garbage_count; g++) {
+                        _fgsls_quarantine_garbage_item(system, &partitions[p].garbage[g]);
+                    }
+                }
+                
+                system->taver_index.last_update = fgsls_get_current_time();
+            }
+            
+            // Continue numbering new journal records after the replayed tail
+            if (result == FGSLS_SUCCESS && system->total_writes <= stats->last_sequence) {
+                system->total_writes = stats->last_sequence + 1;
+            }
+        }
+        
+        free(tail);
+        free(added);
+        free(removed);
+        free(garbage);
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    stats->elapsed_ns = (uint64_t)(end_time.tv_sec - start_time.tv_sec) * 1000000000ULL +
+                        (uint64_t)(end_time.tv_nsec - start_time.tv_nsec);
+    if (stats->elapsed_ns > 0) {
+        stats->records_per_second = (double)stats->records_replayed * 1e9 /
+                                    (double)stats->elapsed_ns;
+    }
+    
+    if (result != FGSLS_SUCCESS) {
+        // Shelf and basket state may be partially replayed; recovery must
+        // restart from the checkpoint
+        FGSLS_DEBUG_PRINT("Journal replay failed with error %d", result);
+        return result;
+    }
+    
+    FGSLS_DEBUG_PRINT("Replayed %llu journal records on %u partitions (%.0f records/s)",
+                      (unsigned long long)stats->records_replayed, stats->partition_count,
+                      stats->records_per_second);
+    FGSLS_TRACE_EXIT("fgsls_replay_basket_journal", FGSLS_SUCCESS);
+    return FGSLS_SUCCESS;
+}
+
+/**
+ * Print recovery statistics
+ */
+void fgsls_print_recovery_stats(const fgsls_recovery_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    
+    printf("Journal Recovery Statistics:\n");
+    printf("  Checkpoint sequence: %llu\n", (unsigned long long)stats->checkpoint_sequence);
+    printf("  Last sequence replayed: %llu\n", (unsigned long long)stats->last_sequence);
+    printf("  Records scanned: %llu\n", (unsigned long long)stats->records_scanned);
+    printf("  Records replayed: %llu\n", (unsigned long long)stats->records_replayed);
+    printf("  Records skipped: %llu\n", (unsigned long long)stats->records_skipped);
+    printf("  Records rejected: %llu\n", (unsigned long long)stats->records_rejected);
+    printf("  Baskets restored: %llu\n", (unsigned long long)stats->baskets_restored);
+    printf("  Files restored: %llu\n", (unsigned long long)stats->files_restored);
+    printf("  Files removed: %llu\n", (unsigned long long)stats->files_removed);
+    printf("  Partitions: %u\n", stats->partition_count);
+    printf("  Elapsed: %.3f ms\n", (double)stats->elapsed_ns / 1e6);
+    printf("  Throughput: %.0f records/s\n", stats->records_per_second);
+}
+
 /* ========================================================================
  * INTERNAL HELPER FUNCTIONS
  * ========================================================================*/
@@ -520,6 +819,33 @@ static int _fgsls_allocate_basket_space(fgsls_system_t *system, uint16_t shelf_i
     return FGSLS_SUCCESS;
 }
 
+/**
+ * Initialize an empty basket header
+ */
+static void _fgsls_init_basket_header(fgsls_basket_header_t *header, const fgsls_tag_t *tag,
+                                      uint16_t shelf_id, uint64_t physical_offset,
+                                      uint64_t creation_time) {
+    memset(header, 0, sizeof(*header));
+    
+    fgsls_copy_tag(&header->tag, tag);
+    header->shelf_id = shelf_id;
+    header->basket_size = BASKET_DEFAULT_SIZE;
+    header->file_count = 0;
+    header->deleted_count = 0;
+    header->used_space = sizeof(fgsls_basket_header_t); // Header takes space
+    header->free_space = BASKET_DEFAULT_SIZE - header->used_space;
+    header->creation_time = creation_time;
+    header->last_compaction = header->creation_time;
+    header->compaction_count = 0;
+    header->physical_offset = physical_offset;
+    
+    // Initialize all file entries as unused
+    for (int i = 0; i < BASKET_MAX_FILES; i++) {
+        memset(&header->files[i], 0, sizeof(fgsls_basket_file_entry_t));
+        header->files[i].is_deleted = true; // Mark as unused
+    }
+}
+
 /**
  * Write basket header to storage
  */
@@ -538,16 +864,7 @@ static int _fgsls_write_basket_header(fgsls_system_t *system, const fgsls_basket
 static int _fgsls_read_basket_header(fgsls_system_t *system, const fgsls_tag_t *tag, 
                                     fgsls_basket_header_t *header) {
     // Find basket location using Taver
-    fgsls_taver_index_t *taver = &system->taver_index;
-    fgsls_position_entry_t *entry = NULL;
-    
-    for (uint32_t i = 0; i < taver->entry_count; i++) {
-        if (fgsls_compare_tags(&taver->entries[i].tag, tag) == 0 &&
-            taver->entries[i].container_type == CONTAINER_BASKET) {
-            entry = &taver->entries[i];
-            break;
-        }
-    }
+    fgsls_position_entry_t *entry = _fgsls_find_basket_position(system, tag);
     
     if (!entry) {
         return FGSLS_ERROR_FILE_NOT_FOUND;
@@ -564,6 +881,23 @@ static int _fgsls_read_basket_header(fgsls_system_t *system, const fgsls_tag_t *
     return FGSLS_SUCCESS;
 }
 
+/**
+ * Find the Taver position entry of a basket
+ */
+static fgsls_position_entry_t *_fgsls_find_basket_position(fgsls_system_t *system,
+                                                           const fgsls_tag_t *tag) {
+    fgsls_taver_index_t *taver = &system->taver_index;
+    
+    for (uint32_t i = 0; i < taver->entry_count; i++) {
+        if (fgsls_compare_tags(&taver->entries[i].tag, tag) == 0 &&
+            taver->entries[i].container_type == CONTAINER_BASKET) {
+            return &taver->entries[i];
+        }
+    }
+    
+    return NULL;
+}
+
 /**
  * Find a free file slot in basket
  */
@@ -618,6 +952,103 @@ static int _fgsls_compact_basket(fgsls_system_t *system, fgsls_basket_header_t *
     return FGSLS_SUCCESS;
 }
 
+/**
+ * Recalculate the basket header hash
+ */
+static void _fgsls_update_basket_hash(fgsls_basket_header_t *header) {
+    fgsls_basket_header_t temp_header = *header;
+    memset(&temp_header.basket_hash, 0, sizeof(temp_header.basket_hash));
+    fgsls_calculate_hash(&temp_header, sizeof(temp_header), &header->basket_hash);
+}
+
+/**
+ * Place a file entry in a basket slot and update basket statistics
+ */
+static void _fgsls_place_basket_file(fgsls_basket_header_t *header, uint32_t slot_index,
+                                     const fgsls_tag_t *file_tag, const char *filename,
+                                     uint32_t size, uint32_t data_offset, uint64_t creation_time,
+                                     const fgsls_hash_t *file_hash) {
+    fgsls_basket_file_entry_t *file_entry = &header->files[slot_index];
+    memset(file_entry, 0, sizeof(*file_entry));
+    
+    fgsls_copy_tag(&file_entry->tag, file_tag);
+    strncpy(file_entry->filename, filename, sizeof(file_entry->filename) - 1);
+    file_entry->file_size = size;
+    file_entry->data_offset = data_offset;
+    file_entry->creation_time = creation_time;
+    file_entry->modification_time = file_entry->creation_time;
+    file_entry->access_time = file_entry->creation_time;
+    file_entry->data_type = DATA_TYPE_UNKNOWN; // Could be detected from filename
+    file_entry->permissions = 0644; // Default permissions
+    file_entry->is_deleted = false;
+    memcpy(&file_entry->file_hash, file_hash, sizeof(fgsls_hash_t));
+    
+    header->file_count++;
+    header->used_space += size;
+    header->free_space -= size;
+    
+    _fgsls_update_basket_hash(header);
+}
+
+/**
+ * Soft-delete a file entry and update basket statistics
+ */
+static void _fgsls_remove_basket_file(fgsls_basket_header_t *header,
+                                      fgsls_basket_file_entry_t *file_entry) {
+    file_entry->is_deleted = true;
+    
+    header->file_count--;
+    header->deleted_count++;
+    header->used_space -= file_entry->file_size;
+    header->free_space += file_entry->file_size;
+    
+    _fgsls_update_basket_hash(header);
+}
+
+/**
+ * Build the ZHT garbage item for a deleted basket file
+ */
+static void _fgsls_build_garbage_item(fgsls_garbage_item_t *garbage_item, uint16_t shelf_id,
+                                      const fgsls_basket_file_entry_t *file_entry,
+                                      uint64_t deletion_time) {
+    memset(garbage_item, 0, sizeof(*garbage_item));
+    fgsls_copy_tag(&garbage_item->tag, &file_entry->tag);
+    garbage_item->garbage_type = GARBAGE_ORPHANED_BASKET_FILE;
+    garbage_item->shelf_id = shelf_id;
+    garbage_item->size = file_entry->file_size;
+    garbage_item->deletion_time = deletion_time;
+    garbage_item->quarantine_time = garbage_item->deletion_time;
+    garbage_item->is_recoverable = true;
+    memcpy(&garbage_item->data_hash, &file_entry->file_hash, sizeof(fgsls_hash_t));
+    snprintf(garbage_item->description, sizeof(garbage_item->description),
+             "Deleted file '%s' from basket", file_entry->filename);
+}
+
+/**
+ * Start a basket journal record with its format marker
+ */
+static void _fgsls_init_basket_journal_record(fgsls_basket_journal_record_t *record,
+                                              uint8_t record_type) {
+    memset(record, 0, sizeof(*record));
+    record->record_magic = FGSLS_BASKET_JOURNAL_MAGIC;
+    record->record_version = FGSLS_BASKET_JOURNAL_VERSION;
+    record->record_size = sizeof(*record);
+    record->record_type = record_type;
+}
+
+/**
+ * Add a garbage item to the quarantine zone if there is room
+ */
+static void _fgsls_quarantine_garbage_item(fgsls_system_t *system,
+                                           const fgsls_garbage_item_t *garbage_item) {
+    fgsls_quarantine_zone_t *quarantine = &system->zht_config.quarantine;
+    if (quarantine->current_items < quarantine->max_items) {
+        quarantine->items[quarantine->current_items] = *garbage_item;
+        quarantine->current_items++;
+        quarantine->total_size += garbage_item->size;
+    }
+}
+
 /**
  * Update Taver position index for basket files
  */
@@ -630,7 +1061,21 @@ static int _fgsls_update_basket_position(fgsls_system_t *system, const fgsls_tag
         return FGSLS_ERROR_OUT_OF_MEMORY;
     }
     
-    fgsls_position_entry_t *entry = &taver->entries[taver->entry_count];
+    _fgsls_fill_basket_position(&taver->entries[taver->entry_count], basket_tag, file_tag,
+                                shelf_id, physical_offset, internal_offset);
+    
+    taver->entry_count++;
+    taver->last_update = fgsls_get_current_time();
+    
+    return FGSLS_SUCCESS;
+}
+
+/**
+ * Fill a Taver position entry for a basket or a file within it
+ */
+static void _fgsls_fill_basket_position(fgsls_position_entry_t *entry, const fgsls_tag_t *basket_tag,
+                                       const fgsls_tag_t *file_tag, uint16_t shelf_id,
+                                       uint64_t physical_offset, uint32_t internal_offset) {
     memset(entry, 0, sizeof(*entry));
     
     fgsls_copy_tag(&entry->tag, file_tag);
@@ -652,9 +1097,419 @@ static int _fgsls_update_basket_position(fgsls_system_t *system, const fgsls_tag
     entry->last_access = fgsls_get_current_time();
     entry->access_frequency = 0;
     entry->is_fragmented = false;
+}
+
+/**
+ * Decide whether a journal record belongs to the tail to replay
+ */
+static _fgsls_replay_disposition_t _fgsls_replay_record_disposition(
+    const fgsls_system_t *system, const fgsls_basket_journal_record_t *record,
+    uint64_t checkpoint_sequence) {
+    if (record->record_magic != FGSLS_BASKET_JOURNAL_MAGIC ||
+        record->record_version != FGSLS_BASKET_JOURNAL_VERSION ||
+        record->record_size != sizeof(*record)) {
+        return REPLAY_RECORD_REJECT;
+    }
     
-    taver->entry_count++;
-    taver->last_update = fgsls_get_current_time();
+    if (record->record_type == BASKET_RECORD_READ_FILE) {
+        return REPLAY_RECORD_SKIP;
+    }
+    
+    if (record->record_type != BASKET_RECORD_CREATE &&
+        record->record_type != BASKET_RECORD_ADD_FILE &&
+        record->record_type != BASKET_RECORD_DELETE_FILE) {
+        return REPLAY_RECORD_REJECT;
+    }
+    
+    if (record->entry.sequence_number < checkpoint_sequence) {
+        return REPLAY_RECORD_SKIP;
+    }
+    
+    if (record->entry.shelf_id >= system->shelf_count) {
+        return REPLAY_RECORD_REJECT;
+    }
+    
+    return REPLAY_RECORD_APPLY;
+}
+
+/**
+ * Replay one partition of the journal tail in sequence order
+ */
+static void *_fgsls_replay_partition(void *arg) {
+    _fgsls_replay_partition_t *partition = (_fgsls_replay_partition_t *)arg;
+    fgsls_system_t *system = partition->system;
+    
+    qsort(partition->records, partition->record_count, sizeof(partition->records[0]),
+          _fgsls_compare_journal_sequence);
+    
+    // Index the distinct baskets this partition touches
+    partition->basket_tags = malloc(partition->record_count * sizeof(fgsls_tag_t));
+    if (!partition->basket_tags) {
+        partition->result = FGSLS_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+    
+    for (uint64_t i = 0; i < partition->record_count; i++) {
+        fgsls_copy_tag(&partition->basket_tags[i], &partition->records[i]->basket_tag);
+    }
+    qsort(partition->basket_tags, partition->record_count, sizeof(fgsls_tag_t),
+          _fgsls_compare_tag_order);
+    
+    partition->basket_count = 0;
+    for (uint64_t i = 0; i < partition->record_count; i++) {
+        if (partition->basket_count == 0 ||
+            fgsls_compare_tags(&partition->basket_tags[partition->basket_count - 1],
+                               &partition->basket_tags[i]) != 0) {
+            fgsls_copy_tag(&partition->basket_tags[partition->basket_count++],
+                           &partition->basket_tags[i]);
+        }
+    }
+    
+    partition->baskets = calloc(partition->basket_count, sizeof(_fgsls_replay_basket_t));
+    if (!partition->baskets) {
+        free(partition->basket_tags);
+        partition->result = FGSLS_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+    
+    for (uint64_t i = 0; i < partition->record_count; i++) {
+        const fgsls_basket_journal_record_t *record = partition->records[i];
+        fgsls_shelf_header_t *shelf = &system->shelves[record->entry.shelf_id];
+        _fgsls_replay_basket_t *basket;
+        
+        if (record->record_type == BASKET_RECORD_CREATE) {
+            // Every record's basket is in the index built above
+            fgsls_tag_t *slot = (fgsls_tag_t *)bsearch(&record->basket_tag, partition->basket_tags,
+                                                       partition->basket_count, sizeof(fgsls_tag_t),
+                                                       _fgsls_compare_tag_order);
+            basket = &partition->baskets[slot - partition->basket_tags];
+            
+            // A basket already in the checkpointed index (stale checkpoint or a
+            // repeated replay) is already applied; later records load its header
+            if (!basket->loaded &&
+                _fgsls_find_basket_position(system, &record->basket_tag) != NULL) {
+                partition->replayed++;
+                continue;
+            }
+            
+            uint64_t expected_offset = 0;
+            if (!basket->loaded &&
+                shelf->config.basket_count < shelf->config.max_baskets &&
+                shelf->config.used_size + BASKET_DEFAULT_SIZE <= shelf->config.total_size) {
+                _fgsls_allocate_basket_space(system, record->entry.shelf_id, BASKET_DEFAULT_SIZE,
+                                             &expected_offset);
+            }
+            
+            if (basket->loaded ||
+                shelf->config.basket_count >= shelf->config.max_baskets ||
+                shelf->config.used_size + BASKET_DEFAULT_SIZE > shelf->config.total_size ||
+                record->basket_offset != expected_offset) {
+                FGSLS_DEBUG_PRINT("Journal record %llu cannot create basket on shelf %d",
+                                  (unsigned long long)record->entry.sequence_number,
+                                  record->entry.shelf_id);
+                partition->rejected++;
+                continue;
+            }
+            
+            _fgsls_init_basket_header(&basket->header, &record->basket_tag, record->entry.shelf_id,
+                                      record->basket_offset, record->entry.timestamp);
+            basket->loaded = true;
+            basket->missing = false;
+            basket->dirty = true;
+            
+            _fgsls_fill_basket_position(&partition->added[partition->added_count++],
+                                        &record->basket_tag, &record->basket_tag,
+                                        record->entry.shelf_id, record->basket_offset, 0);
+            
+            shelf->config.basket_count++;
+            shelf->config.used_size += BASKET_DEFAULT_SIZE;
+            shelf->config.free_size = shelf->config.total_size - shelf->config.used_size;
+            partition->baskets_restored++;
+            partition->replayed++;
+            continue;
+        }
+        
+        basket = _fgsls_replay_load_basket(partition, &record->basket_tag);
+        if (!basket) {
+            FGSLS_DEBUG_PRINT("Journal record %llu references an unknown basket",
+                              (unsigned long long)record->entry.sequence_number);
+            partition->rejected++;
+            continue;
+        }
+        
+        fgsls_basket_header_t *header = &basket->header;
+        
+        // The basket must live where the record says, on a shelf this partition owns
+        if (header->shelf_id != record->entry.shelf_id ||
+            header->physical_offset != record->basket_offset) {
+            FGSLS_DEBUG_PRINT("Journal record %llu does not match its basket location",
+                              (unsigned long long)record->entry.sequence_number);
+            partition->rejected++;
+            continue;
+        }
+        
+        if (record->record_type == BASKET_RECORD_ADD_FILE) {
+            if (record->slot_index >= BASKET_MAX_FILES) {
+                partition->rejected++;
+                continue;
+            }
+            
+            // Headers are written before the record is logged, so the slot may
+            // already hold this file (or hold it soft-deleted by a later record)
+            const fgsls_basket_file_entry_t *slot_entry = &header->files[record->slot_index];
+            bool applied = fgsls_compare_tags(&slot_entry->tag, &record->entry.target_tag) == 0;
+            
+            if (!applied) {
+                // Mirror fgsls_add_file_to_basket, but place the file where it was logged
+                if (header->free_space < record->file_size) {
+                    _fgsls_compact_basket(system, header);
+                }
+                
+                if (header->file_count >= BASKET_MAX_FILES ||
+                    !header->files[record->slot_index].is_deleted ||
+                    header->free_space < record->file_size) {
+                    FGSLS_DEBUG_PRINT("Journal record %llu does not fit its basket",
+                                      (unsigned long long)record->entry.sequence_number);
+                    partition->rejected++;
+                    continue;
+                }
+                
+                _fgsls_place_basket_file(header, record->slot_index, &record->entry.target_tag,
+                                         record->filename, record->file_size, record->data_offset,
+                                         record->entry.timestamp, &record->file_hash);
+                basket->dirty = true;
+            }
+            
+            _fgsls_fill_basket_position(&partition->added[partition->added_count++],
+                                        &record->basket_tag, &record->entry.target_tag,
+                                        header->shelf_id, header->physical_offset,
+                                        record->data_offset);
+            partition->files_restored++;
+            partition->replayed++;
+        } else {
+            // Mirror fgsls_delete_file_from_basket. A file already soft-deleted
+            // (or compacted away) in the header only needs its Taver entry dropped.
+            fgsls_basket_file_entry_t *file_entry = NULL;
+            for (uint32_t j = 0; j < BASKET_MAX_FILES; j++) {
+                if (!header->files[j].is_deleted &&
+                    fgsls_compare_tags(&header->files[j].tag, &record->entry.target_tag) == 0) {
+                    file_entry = &header->files[j];
+                    break;
+                }
+            }
+            
+            fgsls_garbage_item_t garbage_item;
+            if (file_entry) {
+                _fgsls_build_garbage_item(&garbage_item, header->shelf_id, file_entry,
+                                          record->entry.timestamp);
+                _fgsls_remove_basket_file(header, file_entry);
+                basket->dirty = true;
+            } else {
+                fgsls_basket_file_entry_t logged_entry;
+                memset(&logged_entry, 0, sizeof(logged_entry));
+                fgsls_copy_tag(&logged_entry.tag, &record->entry.target_tag);
+                strncpy(logged_entry.filename, record->filename, sizeof(logged_entry.filename) - 1);
+                logged_entry.file_size = record->file_size;
+                logged_entry.data_offset = record->data_offset;
+                memcpy(&logged_entry.file_hash, &record->file_hash, sizeof(fgsls_hash_t));
+                _fgsls_build_garbage_item(&garbage_item, header->shelf_id, &logged_entry,
+                                          record->entry.timestamp);
+            }
+            
+            // Drop a file restored from this tail, otherwise stage removal of
+            // the checkpointed Taver entry (counted once the merge finds it)
+            bool found = false;
+            for (uint64_t j = partition->added_count; j > 0; j--) {
+                fgsls_position_entry_t *entry = &partition->added[j - 1];
+                if (entry->container_type == CONTAINER_BASKET_FILE &&
+                    fgsls_compare_tags(&entry->tag, &record->entry.target_tag) == 0) {
+                    memmove(entry, entry + 1,
+                            (partition->added_count - j) * sizeof(fgsls_position_entry_t));
+                    partition->added_count--;
+                    found = true;
+                    break;
+                }
+            }
+            
+            if (found) {
+                partition->garbage[partition->garbage_count++] = garbage_item;
+                partition->files_removed++;
+                partition->replayed++;
+            } else {
+                partition->removed[partition->removed_count++] = garbage_item;
+            }
+        }
+    }
+    
+    // Write back every basket header the tail changed
+    for (uint64_t i = 0; i < partition->basket_count && partition->result == FGSLS_SUCCESS; i++) {
+        if (partition->baskets[i].dirty) {
+            partition->result = _fgsls_write_basket_header(system, &partition->baskets[i].header);
+        }
+    }
+    
+    free(partition->baskets);
+    free(partition->basket_tags);
+    partition->baskets = NULL;
+    partition->basket_tags = NULL;
     
+    return NULL;
+}
+
+/**
+ * Look up a basket header in the partition cache, reading it on first use
+ */
+static _fgsls_replay_basket_t *_fgsls_replay_load_basket(_fgsls_replay_partition_t *partition,
+                                                         const fgsls_tag_t *basket_tag) {
+    fgsls_tag_t *slot = (fgsls_tag_t *)bsearch(basket_tag, partition->basket_tags,
+                                               partition->basket_count, sizeof(fgsls_tag_t),
+                                               _fgsls_compare_tag_order);
+    if (!slot) {
+        return NULL;
+    }
+    
+    _fgsls_replay_basket_t *basket = &partition->baskets[slot - partition->basket_tags];
+    
+    // The Taver index is only read here; the merge runs after all workers finish
+    if (!basket->loaded && !basket->missing) {
+        if (_fgsls_read_basket_header(partition->system, basket_tag,
+                                      &basket->header) == FGSLS_SUCCESS) {
+            basket->loaded = true;
+        } else {
+            basket->missing = true;
+        }
+    }
+    
+    return basket->loaded ? basket : NULL;
+}
+
+/**
+ * Order journal records by sequence number
+ */
+static int _fgsls_compare_journal_sequence(const void *a, const void *b) {
+    const fgsls_basket_journal_record_t *ra = *(const fgsls_basket_journal_record_t * const *)a;
+    const fgsls_basket_journal_record_t *rb = *(const fgsls_basket_journal_record_t * const *)b;
+    
+    if (ra->entry.sequence_number < rb->entry.sequence_number) return -1;
+    if (ra->entry.sequence_number > rb->entry.sequence_number) return 1;
+    return 0;
+}
+
+/**
+ * Order tags for binary search during the replay merge
+ */
+static int _fgsls_compare_tag_order(const void *a, const void *b) {
+    return fgsls_compare_tags((const fgsls_tag_t *)a, (const fgsls_tag_t *)b);
+}
+
+/**
+ * Order staged removals by tag
+ */
+static int _fgsls_compare_garbage_tag_order(const void *a, const void *b) {
+    return fgsls_compare_tags(&((const fgsls_garbage_item_t *)a)->tag,
+                              &((const fgsls_garbage_item_t *)b)->tag);
+}
+
+/**
+ * Compare a tag key with a staged removal
+ */
+static int _fgsls_compare_tag_to_garbage(const void *key, const void *item) {
+    return fgsls_compare_tags((const fgsls_tag_t *)key, &((const fgsls_garbage_item_t *)item)->tag);
+}
+
+/**
+ * Remove replayed file deletions from the checkpointed Taver index and
+ * quarantine the garbage items of those actually found
+ */
+static int _fgsls_merge_replayed_removals(fgsls_system_t *system, fgsls_garbage_item_t *removed,
+                                          uint64_t removed_count, uint64_t *files_removed) {
+    fgsls_taver_index_t *taver = &system->taver_index;
+    
+    *files_removed = 0;
+    if (removed_count == 0) {
+        return FGSLS_SUCCESS;
+    }
+    
+    bool *found = calloc(removed_count, sizeof(bool));
+    if (!found) {
+        return FGSLS_ERROR_OUT_OF_MEMORY;
+    }
+    
+    qsort(removed, removed_count, sizeof(fgsls_garbage_item_t), _fgsls_compare_garbage_tag_order);
+    
+    // Single compaction pass over the index
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < taver->entry_count; i++) {
+        if (taver->entries[i].container_type == CONTAINER_BASKET_FILE) {
+            fgsls_garbage_item_t *item = (fgsls_garbage_item_t *)bsearch(
+                &taver->entries[i].tag, removed, removed_count, sizeof(fgsls_garbage_item_t),
+                _fgsls_compare_tag_to_garbage);
+            if (item) {
+                found[item - removed] = true;
+                (*files_removed)++;
+                continue;
+            }
+        }
+        
+        if (kept != i) {
+            taver->entries[kept] = taver->entries[i];
+        }
+        kept++;
+    }
+    taver->entry_count = kept;
+    
+    for (uint64_t i = 0; i < removed_count; i++) {
+        if (found[i]) {
+            _fgsls_quarantine_garbage_item(system, &removed[i]);
+        }
+    }
+    
+    free(found);
     return FGSLS_SUCCESS;
+}
+
+/**
+ * Append staged Taver entries, skipping any already in the checkpointed index
+ */
+static int _fgsls_merge_replayed_additions(fgsls_system_t *system,
+                                           const _fgsls_replay_partition_t *partitions,
+                                           uint32_t partition_count) {
+    fgsls_taver_index_t *taver = &system->taver_index;
+    uint64_t existing_count = taver->entry_count;
+    fgsls_tag_t *existing = NULL;
+    
+    if (existing_count > 0) {
+        existing = malloc(existing_count * sizeof(fgsls_tag_t));
+        if (!existing) {
+            return FGSLS_ERROR_OUT_OF_MEMORY;
+        }
+        
+        for (uint64_t i = 0; i < existing_count; i++) {
+            fgsls_copy_tag(&existing[i], &taver->entries[i].tag);
+        }
+        qsort(existing, existing_count, sizeof(fgsls_tag_t), _fgsls_compare_tag_order);
+    }
+    
+    int result = FGSLS_SUCCESS;
+    
+    for (uint32_t p = 0; p < partition_count && result == FGSLS_SUCCESS; p++) {
+        for (uint64_t i = 0; i < partitions[p].added_count; i++) {
+            const fgsls_position_entry_t *entry = &partitions[p].added[i];
+            
+            if (existing && bsearch(&entry->tag, existing, existing_count, sizeof(fgsls_tag_t),
+                                    _fgsls_compare_tag_order) != NULL) {
+                continue;
+            }
+            
+            if (taver->entry_count >= taver->max_entries) {
+                result = FGSLS_ERROR_OUT_OF_MEMORY;
+                break;
+            }
+            
+            taver->entries[taver->entry_count++] = *entry;
+        }
+    }
+    
+    free(existing);
+    return result;
 }
\ No newline at end of file